@@ -0,0 +1,143 @@
+#include "benchmark.h"
+#include <assert.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const int kInitialSamples = 64;
+
+static long allocationCount = 0;
+static long allocationBytes = 0;
+static long freeCount = 0;
+
+// With --wrap, the linker sends the program's malloc calls here and
+// resolves __real_malloc to the C library's.  The declarations are weak
+// so that the harness still links without --wrap, in which case none of
+// the wrappers is ever called.
+extern void *__real_malloc(size_t size) __attribute__((weak));
+extern void *__real_calloc(size_t count, size_t size) __attribute__((weak));
+extern void *__real_realloc(void *ptr, size_t size) __attribute__((weak));
+extern void __real_free(void *ptr) __attribute__((weak));
+
+static void CountAllocation(size_t size) {
+    __atomic_add_fetch(&allocationCount, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&allocationBytes, (long)size, __ATOMIC_RELAXED);
+}
+
+void *__wrap_malloc(size_t size) {
+    void *ptr = __real_malloc(size);
+    if (ptr != NULL) CountAllocation(size);
+    return ptr;
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    void *ptr = __real_calloc(count, size);
+    if (ptr != NULL) CountAllocation(count * size);
+    return ptr;
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    void *result = __real_realloc(ptr, size);
+    if (result != NULL) CountAllocation(size);
+    return result;
+}
+
+void __wrap_free(void *ptr) {
+    if (ptr != NULL) __atomic_add_fetch(&freeCount, 1, __ATOMIC_RELAXED);
+    __real_free(ptr);
+}
+
+void BenchmarkAllocations(benchmarkallocations *counts) {
+    counts->allocations = __atomic_load_n(&allocationCount, __ATOMIC_RELAXED);
+    counts->bytes = __atomic_load_n(&allocationBytes, __ATOMIC_RELAXED);
+    counts->frees = __atomic_load_n(&freeCount, __ATOMIC_RELAXED);
+}
+
+double BenchmarkNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void BenchmarkBegin(benchmark *b, const char *format, ...) {
+    assert(b != NULL && format != NULL);
+    memset(b, 0, sizeof(*b));
+    va_list args;
+    va_start(args, format);
+    vsnprintf(b->name, sizeof(b->name), format, args);
+    va_end(args);
+    b->samplesCapacity = kInitialSamples;
+    b->samples = malloc(b->samplesCapacity * sizeof(double));
+    assert(b->samples != NULL);
+}
+
+void BenchmarkStartBatch(benchmark *b) {
+    BenchmarkAllocations(&b->batchAllocations);
+    b->batchStart = BenchmarkNow();
+}
+
+void BenchmarkEndBatch(benchmark *b, long numOps) {
+    double elapsed = BenchmarkNow() - b->batchStart;
+    benchmarkallocations now;
+    BenchmarkAllocations(&now);
+    assert(numOps > 0);
+    b->allocations.allocations += now.allocations - b->batchAllocations.allocations;
+    b->allocations.bytes += now.bytes - b->batchAllocations.bytes;
+    b->allocations.frees += now.frees - b->batchAllocations.frees;
+    b->elapsed += elapsed;
+    b->numOps += numOps;
+    if (b->numSamples == b->samplesCapacity) {
+        // grown before the next batch starts, so the harness's own
+        // allocations are never charged to the code being measured
+        b->samplesCapacity *= 2;
+        b->samples = realloc(b->samples, b->samplesCapacity * sizeof(double));
+        assert(b->samples != NULL);
+    }
+    b->samples[b->numSamples++] = elapsed * 1e9 / numOps;
+}
+
+static int CompareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// nearest-rank percentile of the sorted samples
+static double Percentile(const double *sorted, int n, double p) {
+    int rank = (int)(p * n + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > n) rank = n;
+    return sorted[rank - 1];
+}
+
+void BenchmarkPrintHeader(FILE *outfile, bool json) {
+    if (json) return;
+    fprintf(outfile, "%-44s %10s %10s %12s %10s %10s %10s %10s %9s %10s\n",
+            "benchmark", "ops", "ns/op", "ops/s", "p50", "p90", "p99", "max", "allocs/op", "bytes/op");
+}
+
+void BenchmarkEnd(benchmark *b, FILE *outfile, bool json) {
+    assert(b->numSamples > 0);
+    qsort(b->samples, b->numSamples, sizeof(double), CompareDoubles);
+    double nsPerOp = b->elapsed * 1e9 / b->numOps;
+    double opsPerSecond = b->numOps / b->elapsed;
+    double p50 = Percentile(b->samples, b->numSamples, 0.50);
+    double p90 = Percentile(b->samples, b->numSamples, 0.90);
+    double p99 = Percentile(b->samples, b->numSamples, 0.99);
+    double max = b->samples[b->numSamples - 1];
+    double allocsPerOp = (double)b->allocations.allocations / b->numOps;
+    double bytesPerOp = (double)b->allocations.bytes / b->numOps;
+    if (json) {
+        fprintf(outfile, "{\"name\":\"%s\",\"ops\":%ld,\"batches\":%d,\"ns_per_op\":%.3f,\"ops_per_sec\":%.1f,"
+                "\"p50_ns\":%.3f,\"p90_ns\":%.3f,\"p99_ns\":%.3f,\"max_ns\":%.3f,"
+                "\"allocs\":%ld,\"alloc_bytes\":%ld,\"frees\":%ld}\n",
+                b->name, b->numOps, b->numSamples, nsPerOp, opsPerSecond, p50, p90, p99, max,
+                b->allocations.allocations, b->allocations.bytes, b->allocations.frees);
+    } else {
+        fprintf(outfile, "%-44s %10ld %10.2f %12.0f %10.2f %10.2f %10.2f %10.2f %9.3f %10.1f\n",
+                b->name, b->numOps, nsPerOp, opsPerSecond, p50, p90, p99, max, allocsPerOp, bytesPerOp);
+    }
+    fflush(outfile);
+    free(b->samples);
+    b->samples = NULL;
+}
@@ -0,0 +1,120 @@
+/**
+ * File: benchmark.h
+ * -----------------
+ * Defines the interface for the benchmark harness.
+ *
+ * A benchmark times a run of operations in batches.  Each batch is timed
+ * on its own, and contributes one sample of nanoseconds per operation,
+ * so besides the overall mean the report carries the median and tail of
+ * the batch samples.  Memory allocation calls made inside the batches are
+ * counted too, provided the program is linked with
+ *
+ *     -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free
+ *
+ * which routes every allocation made by the program's own objects through
+ * the counters in benchmark.c.  Work done between batches (building
+ * inputs, resetting state) is neither timed nor counted.
+ *
+ * Results are written one per line, either as an aligned table for people
+ * or as JSON objects for the scripts that track regressions.
+ */
+
+#ifndef _benchmark_
+#define _benchmark_
+
+#include "bool.h"
+#include <stdio.h>
+
+/**
+ * Type: benchmarkallocations
+ * --------------------------
+ * A snapshot of the process-wide allocation counters: the number of
+ * successful malloc/calloc/realloc calls, the bytes they asked for, and
+ * the number of frees of non-NULL pointers.
+ */
+typedef struct {
+    long allocations;
+    long bytes;
+    long frees;
+} benchmarkallocations;
+
+/**
+ * Type: benchmark
+ * ---------------
+ * The concrete representation of one benchmark in progress.  The client
+ * should only interact with a benchmark through the functions below.
+ */
+typedef struct {
+    char name[96];
+    long numOps;
+    double elapsed;
+    double *samples;
+    int numSamples;
+    int samplesCapacity;
+    double batchStart;
+    benchmarkallocations batchAllocations;
+    benchmarkallocations allocations;
+} benchmark;
+
+/**
+ * Function: BenchmarkBegin
+ * ------------------------
+ * Initializes the specified benchmark under the specified name, which is
+ * what identifies its results from one run to the next.  The name may be
+ * a printf-style format.
+ */
+void BenchmarkBegin(benchmark *b, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * Function: BenchmarkStartBatch
+ * -----------------------------
+ * Starts the clock and the allocation counters for one batch.
+ */
+void BenchmarkStartBatch(benchmark *b);
+
+/**
+ * Function: BenchmarkEndBatch
+ * ---------------------------
+ * Stops the clock for the batch begun by the last BenchmarkStartBatch,
+ * and records that it performed numOps operations (which must be
+ * positive).  Batches should be long enough, a microsecond or more, that
+ * the clock's own overhead does not dominate them.
+ */
+void BenchmarkEndBatch(benchmark *b, long numOps);
+
+/**
+ * Function: BenchmarkEnd
+ * ----------------------
+ * Writes the results of the specified benchmark to outfile, as one line
+ * of text or, if json is true, one JSON object, and releases the memory
+ * the benchmark holds.  The fields are the name, the number of operations,
+ * the mean ns/op and ops/s, the 50th, 90th and 99th percentile and the
+ * maximum of the per-batch ns/op samples, and the allocation counts.
+ */
+void BenchmarkEnd(benchmark *b, FILE *outfile, bool json);
+
+/**
+ * Function: BenchmarkPrintHeader
+ * ------------------------------
+ * Writes the column headings that go above text-format results.  Does
+ * nothing if json is true.
+ */
+void BenchmarkPrintHeader(FILE *outfile, bool json);
+
+/**
+ * Function: BenchmarkAllocations
+ * ------------------------------
+ * Fills counts with the allocation counters as they stand.  The counters
+ * are only maintained when the program is linked with the --wrap options
+ * given above; otherwise they stay at zero.
+ */
+void BenchmarkAllocations(benchmarkallocations *counts);
+
+/**
+ * Function: BenchmarkNow
+ * ----------------------
+ * Returns the monotonic clock in seconds.
+ */
+double BenchmarkNow(void);
+
+#endif
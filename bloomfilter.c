@@ -0,0 +1,79 @@
+#include "bloomfilter.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define kBlockBytes (kBloomFilterWordsPerBlock * (int)sizeof(uint64_t))
+
+// Odd multipliers, one per word of a block.  Multiplying the low half of
+// the hash code by each and keeping the top six bits of the 32-bit
+// product gives eight roughly independent bit positions from one hash.
+static const uint32_t kSalts[kBloomFilterWordsPerBlock] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+};
+
+static uint64_t *BlockFor(const bloomfilter *bf, uint64_t hashcode) {
+    // maps the upper half onto [0, numBlocks) without a division
+    int block = (int)(((hashcode >> 32) * (uint64_t)bf->numBlocks) >> 32);
+    return bf->blocks + (size_t)block * kBloomFilterWordsPerBlock;
+}
+
+static uint64_t BitFor(uint32_t low, int word) {
+    return 1ULL << ((low * kSalts[word]) >> 26);
+}
+
+void BloomFilterNew(bloomfilter *bf, int expectedElements, int bitsPerElement) {
+    assert(bf != NULL);
+    assert(expectedElements >= 0);
+    assert(bitsPerElement >= 1);
+
+    long totalBits = (long)expectedElements * bitsPerElement;
+    long numBlocks = (totalBits + kBlockBytes * 8 - 1) / (kBlockBytes * 8);
+    if (numBlocks < 1) numBlocks = 1;
+    assert(numBlocks <= (1L << 31) - 1);
+    bf->numBlocks = numBlocks;
+    void *blocks;
+    int error = posix_memalign(&blocks, kBlockBytes, (size_t)numBlocks * kBlockBytes);
+    assert(error == 0);
+    bf->blocks = blocks;
+    BloomFilterClear(bf);
+}
+
+void BloomFilterDispose(bloomfilter *bf) {
+    assert(bf != NULL);
+    free(bf->blocks);
+    bf->blocks = NULL;
+    bf->numBlocks = 0;
+    bf->numAdded = 0;
+}
+
+void BloomFilterClear(bloomfilter *bf) {
+    assert(bf != NULL);
+    memset(bf->blocks, 0, (size_t)bf->numBlocks * kBlockBytes);
+    bf->numAdded = 0;
+}
+
+void BloomFilterAdd(bloomfilter *bf, uint64_t hashcode) {
+    uint64_t *block = BlockFor(bf, hashcode);
+    uint32_t low = (uint32_t)hashcode;
+    for (int word = 0; word < kBloomFilterWordsPerBlock; word++) {
+        block[word] |= BitFor(low, word);
+    }
+    bf->numAdded++;
+}
+
+bool BloomFilterMayContain(const bloomfilter *bf, uint64_t hashcode) {
+    const uint64_t *block = BlockFor(bf, hashcode);
+    uint32_t low = (uint32_t)hashcode;
+    // no early exit: eight independent tests are cheaper than seven branches
+    uint64_t missing = 0;
+    for (int word = 0; word < kBloomFilterWordsPerBlock; word++) {
+        missing |= BitFor(low, word) & ~block[word];
+    }
+    return missing == 0;
+}
+
+size_t BloomFilterMemoryUsage(const bloomfilter *bf) {
+    return (size_t)bf->numBlocks * kBlockBytes;
+}
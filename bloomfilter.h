@@ -0,0 +1,103 @@
+/**
+ * File: bloomfilter.h
+ * -------------------
+ * Defines the interface for the bloomfilter.
+ *
+ * A bloomfilter is a compact, approximate set of 64-bit hash codes.  It
+ * answers "might this hash code have been added?" with no false
+ * negatives and a small, tunable rate of false positives, which makes it
+ * a cheap guard in front of a more expensive exact lookup: a "no" from
+ * the filter is definitive and ends the search immediately.
+ *
+ * This is a blocked (or split-block) filter: every hash code selects one
+ * 64-byte block, and all of its bits are set and tested within that one
+ * block, one bit in each of the block's eight 64-bit words.  A query
+ * therefore costs a single cache-line read no matter how many bits it
+ * checks, at the price of a slightly higher false-positive rate than a
+ * classic Bloom filter of the same size.
+ */
+
+#ifndef _bloomfilter_
+#define _bloomfilter_
+
+#include "bool.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Constant: kBloomFilterWordsPerBlock
+ * -----------------------------------
+ * The number of 64-bit words in a block, which is also the number
+ * of bits each hash code sets.  Eight words make one cache line.
+ */
+#define kBloomFilterWordsPerBlock 8
+
+/**
+ * Type: bloomfilter
+ * -----------------
+ * The concrete representation of the bloomfilter.  blocks is aligned to
+ * a 64-byte boundary so that no block straddles two cache lines.  The
+ * client should only interact with a bloomfilter through the functions
+ * below.
+ */
+typedef struct {
+    uint64_t *blocks;
+    int numBlocks;
+    int numAdded;
+} bloomfilter;
+
+/**
+ * Function: BloomFilterNew
+ * ------------------------
+ * Initializes the specified bloomfilter to be empty, sized for about
+ * expectedElements hash codes at bitsPerElement bits apiece.  With
+ * eight bits set per hash code, 8 bits per element gives a false-positive
+ * rate of roughly 3%, 12 gives roughly 0.4%, and 16 roughly 0.1%, as
+ * long as no more than expectedElements codes are added.
+ *
+ * An assert is raised if expectedElements is less than 0 or if
+ * bitsPerElement is less than 1.
+ */
+void BloomFilterNew(bloomfilter *bf, int expectedElements, int bitsPerElement);
+
+/**
+ * Function: BloomFilterDispose
+ * ----------------------------
+ * Releases the memory held by the bloomfilter.
+ */
+void BloomFilterDispose(bloomfilter *bf);
+
+/**
+ * Function: BloomFilterClear
+ * --------------------------
+ * Empties the bloomfilter without changing its size.  A Bloom filter
+ * cannot forget a single hash code, so clients whose sets shrink clear
+ * the filter and add back the codes that remain.
+ */
+void BloomFilterClear(bloomfilter *bf);
+
+/**
+ * Function: BloomFilterAdd
+ * ------------------------
+ * Adds the specified hash code to the bloomfilter.  The code should come
+ * from a good 64-bit hash (such as StringHashBytes): the block is chosen
+ * from its upper half and the bits within the block from its lower half.
+ */
+void BloomFilterAdd(bloomfilter *bf, uint64_t hashcode);
+
+/**
+ * Function: BloomFilterMayContain
+ * -------------------------------
+ * Returns false if the specified hash code was definitely never added to
+ * the bloomfilter, and true if it probably was.
+ */
+bool BloomFilterMayContain(const bloomfilter *bf, uint64_t hashcode);
+
+/**
+ * Function: BloomFilterMemoryUsage
+ * --------------------------------
+ * Returns the number of bytes of bits held by the bloomfilter.
+ */
+size_t BloomFilterMemoryUsage(const bloomfilter *bf);
+
+#endif
@@ -0,0 +1,149 @@
+#include "hashset.h"
+#include "bloomfilter.h"
+#include "stringhash.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+
+static const int kNumWords = 200000;
+static const int kNumRounds = 20;
+static const int kNumBuckets = (1 << 19) - 1; // same table size thesaurus-lookup uses
+static const uint64_t kFilterSeed = 0x5bd1e9955bd1e995ULL;
+
+static int StringHash(const void *elem, int numBuckets)
+{
+  const char *s = *(const char **) elem;
+  return StringHashFolded(s, strlen(s), 0) % numBuckets;
+}
+
+static int StringCompare(const void *elem1, const void *elem2)
+{
+  return StringCompareFolded(*(const char **) elem1, *(const char **) elem2);
+}
+
+static uint64_t StringFilterHash(const void *elem)
+{
+  const char *s = *(const char **) elem;
+  return StringHashFolded(s, strlen(s), kFilterSeed);
+}
+
+/**
+ * Function: BuildWords
+ * --------------------
+ * Fills words with kNumWords lowercase words between 5 and 16 letters
+ * long, drawn from a fixed-seed generator.  Every word ends in the
+ * specified suffix letter, so two calls with different suffixes produce
+ * disjoint sets: one to store, and one that is guaranteed to miss.
+ */
+
+static void BuildWords(char **words, unsigned long state, char suffix)
+{
+  for (int i = 0; i < kNumWords; i++) {
+    state = state * 6364136223846793005UL + 1442695040888963407UL;
+    int length = 5 + (state >> 33) % 12;
+    words[i] = malloc(length + 1);
+    assert(words[i] != NULL);
+    for (int j = 0; j < length - 1; j++) {
+      state = state * 6364136223846793005UL + 1442695040888963407UL;
+      words[i][j] = 'a' + (state >> 33) % 26;
+    }
+    words[i][length - 1] = suffix;
+    words[i][length] = '\0';
+  }
+}
+
+static double Now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * Function: TimeLookups
+ * ---------------------
+ * Returns the average number of nanoseconds HashSetLookup takes
+ * over kNumRounds passes through the specified words.
+ */
+
+static double TimeLookups(const hashset *h, char **words, int *numFound)
+{
+  *numFound = 0;
+  double start = Now();
+  for (int round = 0; round < kNumRounds; round++) {
+    for (int i = 0; i < kNumWords; i++) {
+      if (HashSetLookup(h, &words[i]) != NULL) (*numFound)++;
+    }
+  }
+  *numFound /= kNumRounds;
+  return (Now() - start) * 1e9 / ((double)kNumRounds * kNumWords);
+}
+
+/**
+ * Function: RunBenchmark
+ * ----------------------
+ * Loads the stored words into a fresh hashset, guarded by a filter of
+ * bitsPerElement bits per bucket (or by nothing, if bitsPerElement is
+ * 0).  The table is well under capacity, as thesaurus-lookup's is, so
+ * the filter ends up with more bits per stored word than that.  Reports
+ * the filter's measured false-positive rate on the missing words along
+ * with the cost of a lookup that misses and one that hits.
+ */
+
+static void RunBenchmark(char **stored, char **missing, int bitsPerElement)
+{
+  hashset h;
+  HashSetNew(&h, sizeof(char *), kNumBuckets, StringHash, StringCompare, NULL);
+  if (bitsPerElement > 0) HashSetEnableFilter(&h, StringFilterHash, bitsPerElement);
+  for (int i = 0; i < kNumWords; i++) HashSetEnter(&h, &stored[i]);
+
+  int falsePositives = 0;
+  double bitsPerWord = 0;
+  if (h.filter != NULL) {
+    bitsPerWord = 8.0 * BloomFilterMemoryUsage(h.filter) / kNumWords;
+    for (int i = 0; i < kNumWords; i++) {
+      if (BloomFilterMayContain(h.filter, StringFilterHash(&missing[i]))) falsePositives++;
+    }
+  }
+  int numMissFound, numHitFound;
+  double missTime = TimeLookups(&h, missing, &numMissFound);
+  double hitTime = TimeLookups(&h, stored, &numHitFound);
+  assert(numMissFound == 0 && numHitFound == kNumWords);
+
+  hashsetstats stats;
+  HashSetStats(&h, &stats);
+  char name[32];
+  if (bitsPerElement > 0) {
+    sprintf(name, "%d bits", bitsPerElement);
+  } else {
+    strcpy(name, "no filter");
+  }
+  printf("%-10s %5.1f bits/word   fp rate %6.3f%%   miss %7.2f ns   hit %7.2f ns   %8.1f KB\n",
+         name, bitsPerWord, 100.0 * falsePositives / kNumWords, missTime, hitTime,
+         stats.memoryFootprint / 1024.0);
+  HashSetDispose(&h);
+}
+
+int main(int argc, char **argv)
+{
+  char **stored = malloc(kNumWords * sizeof(char *));
+  char **missing = malloc(kNumWords * sizeof(char *));
+  assert(stored != NULL && missing != NULL);
+  BuildWords(stored, 0x9e3779b97f4a7c15UL, 'a');
+  BuildWords(missing, 0x2545f4914f6cdd1dUL, 'z');
+  printf("%d stored words, %d missing words, %d buckets, %d rounds\n",
+         kNumWords, kNumWords, kNumBuckets, kNumRounds);
+  int bitsPerElement[] = {0, 8, 12, 16};
+  for (int i = 0; i < sizeof(bitsPerElement) / sizeof(bitsPerElement[0]); i++) {
+    RunBenchmark(stored, missing, bitsPerElement[i]);
+  }
+  for (int i = 0; i < kNumWords; i++) {
+    free(stored[i]);
+    free(missing[i]);
+  }
+  free(stored);
+  free(missing);
+  return 0;
+}